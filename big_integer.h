@@ -2,16 +2,48 @@
 #define BIG_INTEGER_H
 
 #include <iosfwd>
+#include <memory>
 #include <vector>
 #include <cstdint>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <charconv>
 #include "dynamic_storage.h"
 
+// limb width in bits: 64 when the compiler offers unsigned __int128 for double-width intermediates, 32 otherwise;
+// may be set to 32 explicitly, but has to be the same in every translation unit
+#ifndef BIG_INTEGER_LIMB_BITS
+#ifdef __SIZEOF_INT128__
+#define BIG_INTEGER_LIMB_BITS 64
+#else
+#define BIG_INTEGER_LIMB_BITS 32
+#endif
+#endif
+
+// the outcome of serialize, encode_key and their inverses in the manner of std::to_chars_result: past the bytes
+// used, or an error
+struct serialize_result {
+    unsigned char* ptr;
+    std::errc ec;
+};
+
+struct deserialize_result {
+    unsigned char const* ptr;
+    std::errc ec;
+};
+
+class big_integer_view;
+
 struct big_integer {
     big_integer();
     big_integer(big_integer const& x);
     big_integer(int32_t val);
     explicit big_integer(std::string_view str);
+    explicit big_integer(big_integer_view x); // a copy of the viewed value
+    // digits 0-9 and then letters in either case, radix 2..36; power-of-two radices map digits to bits directly
+    big_integer(std::string_view str, int radix);
     ~big_integer();
 
     big_integer& operator=(big_integer const& rhs);
@@ -41,11 +73,26 @@ struct big_integer {
 
     void swap(big_integer& x) noexcept;
 
+    class small_divisor;
+    big_integer& operator/=(small_divisor const& rhs);
+    big_integer& operator%=(small_divisor const& rhs);
+
+    // products of operands longer than a few thousand limbs are split over this many threads, 1 (default) turns it off;
+    // must not be called while other threads multiply
+    static void set_multiplication_threads(unsigned threads);
+
     friend big_integer operator+(big_integer const& lhs, big_integer const& rhs);
     friend big_integer operator-(big_integer const& lhs, big_integer const& rhs);
     friend big_integer operator*(big_integer const& lhs, big_integer const& rhs);
     friend big_integer operator/(big_integer const& lhs, big_integer const& rhs);
     friend big_integer operator%(big_integer const& lhs, big_integer const& rhs);
+    // lhs / rhs and lhs % rhs from a single division
+    friend std::pair<big_integer, big_integer> divmod(big_integer const& lhs, big_integer const& rhs);
+    // lhs / rhs when rhs is known to divide lhs, computed from the low end; other operands give an unspecified value
+    friend big_integer divexact(big_integer const& lhs, big_integer const& rhs);
+    friend big_integer operator/(big_integer const& lhs, small_divisor const& rhs);
+    friend big_integer operator%(big_integer const& lhs, small_divisor const& rhs);
+    friend std::pair<big_integer, big_integer> divmod(big_integer const& lhs, small_divisor const& rhs);
 
     friend big_integer operator&(big_integer const& lhs, big_integer const& rhs);
     friend big_integer operator|(big_integer const& lhs, big_integer const& rhs);
@@ -64,15 +111,286 @@ struct big_integer {
     friend void swap(big_integer& lhs, big_integer& rhs) noexcept;
 
     friend big_integer abs(big_integer const& x);
+    friend big_integer sqr(big_integer const& x);
+    // a * b mod 2^bits and a * b >> bits, only the kept part of the product is computed where the sizes allow
+    friend big_integer mul_low(big_integer const& a, big_integer const& b, int bits);
+    friend big_integer mul_high(big_integer const& a, big_integer const& b, int bits);
+    // 2^precision_bits / x rounded toward zero, by Newton iteration
+    friend big_integer reciprocal(big_integer const& x, int precision_bits);
     friend std::string to_string(big_integer const& x);
+    friend std::string to_string(big_integer const& x, int radix); // lower-case letters above 9
+    // <charconv> contracts, base 2..36; a buffer of to_chars_bound(x, base) characters always suffices,
+    // and then short values are written without heap allocation
+    friend size_t to_chars_bound(big_integer const& x, int base);
+    friend std::to_chars_result to_chars(char* first, char* last, big_integer const& x, int base);
+    friend std::from_chars_result from_chars(char const* first, char const* last, big_integer& value, int base);
+    // decimal text streamed in blocks of a few kilobytes each way, neither direction holds the whole text at once
+    friend std::ostream& operator<<(std::ostream& os, big_integer const& x);
+    friend std::istream& operator>>(std::istream& is, big_integer& x);
+    // a versioned binary format, the same for either limb width: a tag byte, then a zigzag varint for values that
+    // fit 64 bits or else a varint byte count and the little-endian bytes of the magnitude; serialized_size(x) is
+    // exactly the number of bytes serialize writes
+    friend size_t serialized_size(big_integer const& x);
+    friend serialize_result serialize(unsigned char* first, unsigned char* last, big_integer const& x);
+    friend deserialize_result deserialize(unsigned char const* first, unsigned char const* last, big_integer& value);
+    // keys whose unsigned byte order is the numeric order, so that memcmp compares them and none is a prefix of
+    // another: a tag byte for the sign and the length of the length, the byte count of the magnitude and then its
+    // bytes, both big-endian and complemented for negative values; key_size(x) is exactly what encode_key writes
+    friend size_t key_size(big_integer const& x);
+    friend serialize_result encode_key(unsigned char* first, unsigned char* last, big_integer const& x);
+    friend deserialize_result decode_key(unsigned char const* first, unsigned char const* last, big_integer& value);
+
+    // built-in integers take a one- or two-limb path instead of being converted to big_integer first
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    big_integer& operator+=(T rhs) { return *this = add_integral(*this, rhs); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    big_integer& operator-=(T rhs) { return *this = add_integral(*this, -integral(rhs)); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    big_integer& operator*=(T rhs) { return *this = mul_integral(*this, rhs); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    big_integer& operator/=(T rhs) { return *this = div_integral(*this, rhs); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    big_integer& operator%=(T rhs) { return *this = mod_integral(*this, rhs); }
+
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator+(big_integer const& lhs, T rhs) { return add_integral(lhs, rhs); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator+(T lhs, big_integer const& rhs) { return add_integral(rhs, lhs); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator-(big_integer const& lhs, T rhs) { return add_integral(lhs, -integral(rhs)); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator-(T lhs, big_integer const& rhs) { return -add_integral(rhs, -integral(lhs)); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator*(big_integer const& lhs, T rhs) { return mul_integral(lhs, rhs); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator*(T lhs, big_integer const& rhs) { return mul_integral(rhs, lhs); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator/(big_integer const& lhs, T rhs) { return div_integral(lhs, rhs); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator/(T lhs, big_integer const& rhs) { return div_integral(lhs, rhs); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator%(big_integer const& lhs, T rhs) { return mod_integral(lhs, rhs); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator%(T lhs, big_integer const& rhs) { return mod_integral(lhs, rhs); }
+
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator==(big_integer const& lhs, T rhs) { return cmp_integral(lhs, rhs) == 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator==(T lhs, big_integer const& rhs) { return cmp_integral(rhs, lhs) == 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator!=(big_integer const& lhs, T rhs) { return cmp_integral(lhs, rhs) != 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator!=(T lhs, big_integer const& rhs) { return cmp_integral(rhs, lhs) != 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator<(big_integer const& lhs, T rhs) { return cmp_integral(lhs, rhs) < 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator<(T lhs, big_integer const& rhs) { return cmp_integral(rhs, lhs) > 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator>(big_integer const& lhs, T rhs) { return cmp_integral(lhs, rhs) > 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator>(T lhs, big_integer const& rhs) { return cmp_integral(rhs, lhs) < 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator<=(big_integer const& lhs, T rhs) { return cmp_integral(lhs, rhs) <= 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator<=(T lhs, big_integer const& rhs) { return cmp_integral(rhs, lhs) >= 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator>=(big_integer const& lhs, T rhs) { return cmp_integral(lhs, rhs) >= 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator>=(T lhs, big_integer const& rhs) { return cmp_integral(rhs, lhs) <= 0; }
 
 private:
     struct helper;
+    friend class big_integer_view;
+
+    struct integral { // a built-in integer as sign and 64-bit magnitude
+        bool negative;
+        uint64_t magnitude;
+
+        template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+        integral(T val) : negative(false), magnitude(static_cast<uint64_t>(val))
+        {
+            if constexpr (std::is_signed_v<T>) {
+                if (val < 0) {
+                    negative = true;
+                    magnitude = 0 - magnitude;
+                }
+            }
+        }
+
+        integral(bool negative, uint64_t magnitude) : negative(negative && magnitude), magnitude(magnitude) { }
+
+        integral operator-() const
+        {
+            return {!negative, magnitude};
+        }
+    };
 
-    typedef dynamic_storage<uint32_t> container_t;
+#if BIG_INTEGER_LIMB_BITS == 64
+    typedef uint64_t limb_t;
+#else
+    typedef uint32_t limb_t;
+#endif
+    typedef dynamic_storage<limb_t> container_t;
     container_t data;
 
     explicit big_integer(container_t const& data);
+
+    static big_integer add_integral(big_integer const& lhs, integral rhs);
+    static big_integer mul_integral(big_integer const& lhs, integral rhs);
+    static big_integer div_integral(big_integer const& lhs, integral rhs);
+    static big_integer div_integral(integral lhs, big_integer const& rhs);
+    static big_integer mod_integral(big_integer const& lhs, integral rhs);
+    static big_integer mod_integral(integral lhs, big_integer const& rhs);
+    static int cmp_integral(big_integer const& lhs, integral rhs);
+};
+
+// a divisor of at most one limb with its Moller-Granlund reciprocal precomputed, so that dividing by it
+// multiplies instead of dividing every limb; wider values (above 2^32 with 32-bit limbs) take the regular division
+class big_integer::small_divisor {
+public:
+    explicit small_divisor(uint64_t divisor);
+
+    uint64_t value() const
+    {
+        return divisor;
+    }
+
+private:
+    friend struct big_integer::helper;
+
+    uint64_t divisor;
+    limb_t normalized; // divisor shifted left until the top bit is set
+    limb_t inverse;
+    unsigned shift;
+};
+
+// a read-only integer over limbs kept elsewhere, e.g. in a memory-mapped file: a magnitude of n limbs, the least
+// significant first, and a sign. Nothing is copied, so the limbs have to outlive the view. A big_integer converts to
+// a view of its own limbs, a negative one included, so the operations below take either kind of operand and always
+// return an owning big_integer
+class big_integer_view {
+public:
+    typedef big_integer::limb_t limb_t; // uint32_t when BIG_INTEGER_LIMB_BITS is 32, uint64_t otherwise
+
+    big_integer_view(limb_t const* limbs, size_t n, bool negative = false);
+#if BIG_INTEGER_LIMB_BITS == 64
+    // 32-bit words, the least significant first: read in place as pairs on a little-endian host when they are
+    // aligned for limb_t and an even number of them is significant, otherwise widened into limbs the view keeps
+    big_integer_view(uint32_t const* words, size_t n, bool negative = false);
+#endif
+    big_integer_view(big_integer const& x);
+
+    friend big_integer operator+(big_integer_view lhs, big_integer_view rhs) { return add(lhs, rhs, false); }
+    friend big_integer operator-(big_integer_view lhs, big_integer_view rhs) { return add(lhs, rhs, true); }
+    friend big_integer operator*(big_integer_view lhs, big_integer_view rhs) { return mul(lhs, rhs); }
+    friend big_integer operator/(big_integer_view lhs, big_integer_view rhs) { return div(lhs, rhs).first; }
+    friend big_integer operator%(big_integer_view lhs, big_integer_view rhs) { return div(lhs, rhs).second; }
+    friend std::pair<big_integer, big_integer> divmod(big_integer_view lhs, big_integer_view rhs)
+    {
+        return div(lhs, rhs);
+    }
+
+    friend big_integer operator<<(big_integer_view lhs, int val) { return shift(lhs, val); }
+    friend big_integer operator>>(big_integer_view lhs, int val) { return shift(lhs, -val); }
+
+    friend bool operator==(big_integer_view lhs, big_integer_view rhs) { return cmp(lhs, rhs) == 0; }
+    friend bool operator!=(big_integer_view lhs, big_integer_view rhs) { return cmp(lhs, rhs) != 0; }
+    friend bool operator<(big_integer_view lhs, big_integer_view rhs) { return cmp(lhs, rhs) < 0; }
+    friend bool operator>(big_integer_view lhs, big_integer_view rhs) { return cmp(lhs, rhs) > 0; }
+    friend bool operator<=(big_integer_view lhs, big_integer_view rhs) { return cmp(lhs, rhs) <= 0; }
+    friend bool operator>=(big_integer_view lhs, big_integer_view rhs) { return cmp(lhs, rhs) >= 0; }
+
+    // built-in integers are viewed in place, as one or two limbs
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator+(big_integer_view lhs, T rhs) { return add(lhs, scalar(rhs), false); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator+(T lhs, big_integer_view rhs) { return add(scalar(lhs), rhs, false); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator-(big_integer_view lhs, T rhs) { return add(lhs, scalar(rhs), true); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator-(T lhs, big_integer_view rhs) { return add(scalar(lhs), rhs, true); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator*(big_integer_view lhs, T rhs) { return mul(lhs, scalar(rhs)); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator*(T lhs, big_integer_view rhs) { return mul(scalar(lhs), rhs); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator/(big_integer_view lhs, T rhs) { return div(lhs, scalar(rhs)).first; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator/(T lhs, big_integer_view rhs) { return div(scalar(lhs), rhs).first; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator%(big_integer_view lhs, T rhs) { return div(lhs, scalar(rhs)).second; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend big_integer operator%(T lhs, big_integer_view rhs) { return div(scalar(lhs), rhs).second; }
+
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator==(big_integer_view lhs, T rhs) { return cmp(lhs, scalar(rhs)) == 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator==(T lhs, big_integer_view rhs) { return cmp(scalar(lhs), rhs) == 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator!=(big_integer_view lhs, T rhs) { return cmp(lhs, scalar(rhs)) != 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator!=(T lhs, big_integer_view rhs) { return cmp(scalar(lhs), rhs) != 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator<(big_integer_view lhs, T rhs) { return cmp(lhs, scalar(rhs)) < 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator<(T lhs, big_integer_view rhs) { return cmp(scalar(lhs), rhs) < 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator>(big_integer_view lhs, T rhs) { return cmp(lhs, scalar(rhs)) > 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator>(T lhs, big_integer_view rhs) { return cmp(scalar(lhs), rhs) > 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator<=(big_integer_view lhs, T rhs) { return cmp(lhs, scalar(rhs)) <= 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator<=(T lhs, big_integer_view rhs) { return cmp(scalar(lhs), rhs) <= 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator>=(big_integer_view lhs, T rhs) { return cmp(lhs, scalar(rhs)) >= 0; }
+    template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    friend bool operator>=(T lhs, big_integer_view rhs) { return cmp(scalar(lhs), rhs) >= 0; }
+
+    friend big_integer abs(big_integer_view x) { return magnitude(x); }
+    // bit index of x in twos-complement form, infinitely sign extended (so (x >> index) & 1), and the number of
+    // bits of |x|, 0 for zero; declared outside the class as well, so that a big_integer converts to the view
+    friend bool bit_test(big_integer_view x, size_t index) { return bit(x, index); }
+    friend size_t bit_length(big_integer_view x) { return bits(x); }
+    friend std::string to_string(big_integer_view x, int radix = 10) { return text(x, radix); }
+
+private:
+    friend struct big_integer::helper;
+
+    struct scalar { // the magnitude of a built-in integer as the limbs of a view
+        limb_t limbs[sizeof(uint64_t) / sizeof(limb_t)];
+        bool negative;
+
+        template<typename T>
+        explicit scalar(T val) : scalar(big_integer::integral(val)) { }
+
+        explicit scalar(big_integer::integral val) : limbs{}, negative(val.negative)
+        {
+            for (size_t i = 0; i < std::size(limbs); ++i) {
+                limbs[i] = static_cast<limb_t>(val.magnitude >> (i * 8 * sizeof(limb_t)));
+            }
+        }
+
+        operator big_integer_view() const { return {limbs, std::size(limbs), negative}; }
+    };
+
+    static big_integer add(big_integer_view lhs, big_integer_view rhs, bool subtract);
+    static big_integer mul(big_integer_view lhs, big_integer_view rhs);
+    static std::pair<big_integer, big_integer> div(big_integer_view lhs, big_integer_view rhs);
+    static big_integer shift(big_integer_view x, int val); // to the left, floor division by 2^-val when negative
+    static int cmp(big_integer_view lhs, big_integer_view rhs);
+    static std::string text(big_integer_view x, int radix);
+    static big_integer magnitude(big_integer_view x);
+    static bool bit(big_integer_view x, size_t index);
+    static size_t bits(big_integer_view x);
+
+    limb_t const* limbs; // without leading zero limbs, at least one
+    size_t n;
+    bool negative; // never set for zero
+    // the limbs of a negative big_integer: 2^(limb_bits n) - |x|, read as the magnitude on the fly instead of
+    // being negated into a copy first; only set together with negative
+    bool complement;
+    std::shared_ptr<limb_t const[]> widened; // what limbs points to when 32-bit words could not be read in place
 };
 
 big_integer operator+(big_integer const& lhs, big_integer const& rhs);
@@ -80,6 +398,11 @@ big_integer operator-(big_integer const& lhs, big_integer const& rhs);
 big_integer operator*(big_integer const& lhs, big_integer const& rhs);
 big_integer operator/(big_integer const& lhs, big_integer const& rhs);
 big_integer operator%(big_integer const& lhs, big_integer const& rhs);
+std::pair<big_integer, big_integer> divmod(big_integer const& lhs, big_integer const& rhs);
+big_integer divexact(big_integer const& lhs, big_integer const& rhs);
+big_integer operator/(big_integer const& lhs, big_integer::small_divisor const& rhs);
+big_integer operator%(big_integer const& lhs, big_integer::small_divisor const& rhs);
+std::pair<big_integer, big_integer> divmod(big_integer const& lhs, big_integer::small_divisor const& rhs);
 
 big_integer operator&(big_integer const& lhs, big_integer const& rhs);
 big_integer operator|(big_integer const& lhs, big_integer const& rhs);
@@ -98,7 +421,25 @@ bool operator>=(big_integer const& lhs, big_integer const& rhs);
 void swap(big_integer& lhs, big_integer& rhs) noexcept;
 
 big_integer abs(big_integer const& x);
+big_integer abs(big_integer_view x);
+bool bit_test(big_integer_view x, size_t index);
+size_t bit_length(big_integer_view x);
+big_integer sqr(big_integer const& x);
+big_integer mul_low(big_integer const& a, big_integer const& b, int bits);
+big_integer mul_high(big_integer const& a, big_integer const& b, int bits);
+big_integer reciprocal(big_integer const& x, int precision_bits);
 std::string to_string(big_integer const& x);
+std::string to_string(big_integer const& x, int radix);
+size_t to_chars_bound(big_integer const& x, int base = 10);
+std::to_chars_result to_chars(char* first, char* last, big_integer const& x, int base = 10);
+std::from_chars_result from_chars(char const* first, char const* last, big_integer& value, int base = 10);
 std::ostream& operator<<(std::ostream& os, big_integer const& x);
+std::istream& operator>>(std::istream& is, big_integer& x);
+size_t serialized_size(big_integer const& x);
+serialize_result serialize(unsigned char* first, unsigned char* last, big_integer const& x);
+deserialize_result deserialize(unsigned char const* first, unsigned char const* last, big_integer& value);
+size_t key_size(big_integer const& x);
+serialize_result encode_key(unsigned char* first, unsigned char* last, big_integer const& x);
+deserialize_result decode_key(unsigned char const* first, unsigned char const* last, big_integer& value);
 
 #endif //BIG_INTEGER_H
\ No newline at end of file
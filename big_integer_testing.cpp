@@ -1,11 +1,16 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <vector>
 #include <utility>
+#include <sstream>
+#include <iomanip>
+#include <thread>
 #include <gtest/gtest.h>
 
 #include "big_integer.h"
+#include "simd_kernels.h"
 
 TEST(correctness, two_plus_two)
 {
@@ -726,4 +731,976 @@ TEST(correctness, div_randomized)
         EXPECT_GE(residue, 0);
         EXPECT_LT(residue, divisor);
     }
-}
\ No newline at end of file
+}
+namespace {
+big_integer mul_by_digits(big_integer const& a, big_integer const& b) // b >= 0
+{
+    std::vector<big_integer> digits;
+    for (big_integer rest = b; rest != 0; rest /= 65536) {
+        digits.push_back(rest % 65536);
+    }
+    big_integer result = 0;
+    for (auto it = digits.rbegin(); it != digits.rend(); ++it) {
+        result = result * 65536 + a * *it;
+    }
+    return result;
+}
+}
+
+TEST(correctness, mul_karatsuba_long)
+{
+    big_integer a = rand_big(100);
+    big_integer b = rand_big(70);
+    big_integer expected = mul_by_digits(a, b);
+    EXPECT_EQ(a * b, expected);
+    EXPECT_EQ(-b * a, -expected);
+}
+
+TEST(correctness, mul_toom_long)
+{
+    big_integer a = rand_big(1400);
+    big_integer b = rand_big(1300);
+    big_integer expected = mul_by_digits(a, b);
+    EXPECT_EQ(a * b, expected);
+    EXPECT_EQ(-b * a, -expected);
+    big_integer c = rand_big(300);
+    EXPECT_EQ(c * -b, -mul_by_digits(b, c));
+}
+
+TEST(correctness, mul_merge_randomized_long)
+{
+    std::vector<big_integer> x;
+    for (size_t i = 0; i != 64; ++i)
+        x.push_back(rand_big(40));
+
+    big_integer a = merge_all(x);
+    big_integer b = merge_all(x);
+
+    EXPECT_TRUE(a == b);
+}
+
+TEST(correctness, mul_ntt_long)
+{
+    big_integer a = rand_big(720);
+    big_integer b = rand_big(680);
+    for (int i = 0; i != 7; ++i) { // about 2.7 million bits, past ntt_threshold for either limb width
+        a = a * a + rand_big(2);
+        b = b * b - rand_big(2);
+    }
+    big_integer ab = a * b;
+    for (int mod : {2147483647, 2147483629, 2147483587}) {
+        EXPECT_EQ(ab % mod, (a % mod) * (b % mod) % mod);
+    }
+    int half = 1300000; // both halves of b fall below ntt_threshold and take the unbalanced path
+    big_integer b_low = b % (big_integer(1) << half);
+    EXPECT_EQ(ab, (a * (b >> half) << half) + a * b_low);
+    EXPECT_EQ(sqr(a), a * (a + 1) - a);
+}
+
+TEST(correctness, sqr_long)
+{
+    for (size_t size : {1, 10, 60, 200, 700, 1400}) {
+        big_integer a = rand_big(size);
+        big_integer b = a;
+        big_integer expected = a * (a + 1) - a;
+        EXPECT_EQ(sqr(a), expected);
+        EXPECT_EQ(sqr(-a), expected);
+        EXPECT_EQ(a * a, expected);
+        EXPECT_EQ(a * b, expected);
+        EXPECT_EQ(-a * -b, expected);
+    }
+    EXPECT_EQ(sqr(0), 0);
+    EXPECT_EQ(sqr(std::numeric_limits<int>::min()), big_integer("4611686018427387904"));
+}
+
+TEST(correctness, compare_negative)
+{
+    EXPECT_LT(big_integer(-2), big_integer(-1));
+    EXPECT_GT(big_integer("-100000000000000000000"), big_integer("-100000000000000000001"));
+    EXPECT_LT(big_integer("-100000000000000000000"), big_integer(-1));
+}
+
+TEST(correctness, shift_whole_limbs)
+{
+    big_integer a("123456789012345678901234567890");
+    EXPECT_EQ(a << 32, big_integer("530242871277196831127719683112241725440"));
+    EXPECT_EQ(a << 64, big_integer("2277375791072698140248390838022561708011411210240"));
+    EXPECT_EQ(a >> 32, big_integer("28744523649184424174"));
+    EXPECT_EQ(a >> 0, a);
+    EXPECT_EQ(-a >> 32, big_integer("-28744523649184424175"));
+    EXPECT_EQ(big_integer(-5) >> 100, -1);
+}
+
+TEST(correctness, mul_parallel)
+{
+    auto concat = [](size_t pieces) {
+        big_integer x = rand_big(100);
+        for (size_t i = 1; i != pieces; ++i)
+            x = (x << 3200) + rand_big(100);
+        return x;
+    };
+    big_integer a = concat(820); // 2.6 million bits, the NTT tier with either limb width
+    big_integer b = concat(810);
+    big_integer c = concat(60); // toom4 with a balanced operand, karatsuba with an unbalanced one
+    big_integer d = concat(35);
+    std::vector<big_integer> expected = {a * b, sqr(a), c * c, c * (c + 1), c * d};
+
+    big_integer::set_multiplication_threads(4);
+    std::vector<big_integer> parallel = {a * b, sqr(a), c * c, c * (c + 1), c * d};
+    big_integer::set_multiplication_threads(1);
+
+    EXPECT_TRUE(parallel == expected);
+}
+
+TEST(correctness, mul_unbalanced)
+{
+    big_integer a = rand_big(100);
+    for (int i = 0; i != 5; ++i)
+        a = a * a + rand_big(2); // 3200 limbs
+    for (size_t size : {40, 150, 333, 700}) {
+        big_integer b = rand_big(size);
+        big_integer ab = a * b;
+        EXPECT_EQ(ab, b * a);
+        EXPECT_EQ((a + 1) * b - ab, b);
+        EXPECT_EQ(a * (b - 1) - ab, -a);
+        for (int mod : {2147483647, 2147483629}) {
+            EXPECT_EQ(ab % mod, (a % mod) * (b % mod) % mod);
+        }
+    }
+}
+
+namespace {
+template<typename T>
+void check_mixed(std::vector<big_integer> const& values, T rhs)
+{
+    big_integer b(std::to_string(rhs));
+    for (big_integer const& a : values) {
+        EXPECT_EQ(a + rhs, a + b);
+        EXPECT_EQ(rhs + a, b + a);
+        EXPECT_EQ(a - rhs, a - b);
+        EXPECT_EQ(rhs - a, b - a);
+        EXPECT_EQ(a * rhs, a * b);
+        EXPECT_EQ(rhs * a, b * a);
+        if (rhs != 0) {
+            EXPECT_EQ(a / rhs, a / b);
+            EXPECT_EQ(a % rhs, a % b);
+        }
+        if (a != 0) {
+            EXPECT_EQ(rhs / a, b / a);
+            EXPECT_EQ(rhs % a, b % a);
+        }
+        EXPECT_EQ(a == rhs, a == b);
+        EXPECT_EQ(rhs != a, b != a);
+        EXPECT_EQ(a < rhs, a < b);
+        EXPECT_EQ(rhs < a, b < a);
+        EXPECT_EQ(a >= rhs, a >= b);
+        EXPECT_EQ(rhs >= a, b >= a);
+        big_integer c = a;
+        c *= rhs;
+        c -= rhs;
+        EXPECT_EQ(c, a * b - b);
+    }
+}
+}
+
+TEST(correctness, mixed_type_arithmetic)
+{
+    std::vector<big_integer> values = {0, 1, -1, 7, -7, std::numeric_limits<int>::min(),
+                                       big_integer("4294967296"), big_integer("-4294967296"),
+                                       big_integer("18446744073709551615"), big_integer("-18446744073709551615"),
+                                       big_integer("18446744073709551616"), big_integer("-9223372036854775808"),
+                                       big_integer("123456789012345678901234567890"),
+                                       big_integer("-123456789012345678901234567890")};
+    for (int32_t v : {0, 1, -1, 10, -7, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()})
+        check_mixed(values, v);
+    for (uint32_t v : {0u, 3u, 4294967295u})
+        check_mixed(values, v);
+    for (int64_t v : {int64_t(-5), int64_t(1) << 40, std::numeric_limits<int64_t>::min(),
+                      std::numeric_limits<int64_t>::max()})
+        check_mixed(values, v);
+    for (uint64_t v : {uint64_t(9), uint64_t(1) << 32, std::numeric_limits<uint64_t>::max()})
+        check_mixed(values, v);
+    check_mixed(values, -3LL);
+    check_mixed(values, 12345678901234ULL);
+    check_mixed(values, static_cast<short>(-300));
+    check_mixed(values, static_cast<unsigned char>(200));
+}
+
+TEST(correctness, mixed_type_division_by_zero)
+{
+    EXPECT_THROW(big_integer(5) / 0, std::invalid_argument);
+    EXPECT_THROW(big_integer(5) % 0ULL, std::invalid_argument);
+    EXPECT_THROW(5 / big_integer(0), std::invalid_argument);
+    EXPECT_THROW(5L % big_integer(), std::invalid_argument);
+}
+
+TEST(correctness, long_carry_chains)
+{
+    for (int bits : {31, 32, 33, 255, 256, 257, 511, 512, 513, 1000, 4096}) {
+        big_integer ones = (big_integer(1) << bits) - 1;
+        EXPECT_EQ(ones + 1, big_integer(1) << bits);
+        EXPECT_EQ((ones + 1) - 1, ones);
+        EXPECT_EQ(-ones - 1, -(big_integer(1) << bits));
+        EXPECT_EQ(ones * ones + 2 * ones + 1, big_integer(1) << (2 * bits));
+        EXPECT_EQ(ones * 0xFFFFFFFFu, (ones << 32) - ones);
+        EXPECT_EQ(~ones, -(big_integer(1) << bits));
+    }
+}
+
+TEST(correctness, bitwise_long_normalized)
+{
+    big_integer a = (big_integer(1) << 700) + (big_integer(1) << 100) + 5;
+    big_integer b = -(big_integer(1) << 700) + (big_integer(1) << 100) + 3;
+    EXPECT_EQ(a & b, (big_integer(1) << 700) + (big_integer(1) << 100) + 1);
+    EXPECT_EQ(a ^ a, 0);
+    EXPECT_EQ((a | b) ^ (a & b), a ^ b);
+    EXPECT_EQ(a ^ b, -(big_integer(1) << 701) + 6);
+    EXPECT_EQ(b & -1, b);
+    EXPECT_EQ(b | 0, b);
+    EXPECT_EQ(a | -1, -1);
+}
+
+TEST(correctness, decimal_chunk_boundaries)
+{
+    std::string nines;
+    for (size_t len = 1; len != 60; ++len) {
+        nines += '9';
+        big_integer x(nines);
+        EXPECT_EQ(to_string(x), nines);
+        EXPECT_EQ(to_string(x + 1), "1" + std::string(len, '0'));
+        EXPECT_EQ(to_string(-x), "-" + nines);
+        EXPECT_EQ(big_integer("1" + std::string(len, '0')), x + 1);
+    }
+    EXPECT_EQ(to_string(big_integer(1) << 64), "18446744073709551616");
+    EXPECT_EQ(to_string((big_integer(1) << 64) - 1), "18446744073709551615");
+    EXPECT_EQ(big_integer("00000000000000000000000000018446744073709551616"), big_integer(1) << 64);
+    EXPECT_EQ(to_string(big_integer("-10000000000000000000000000000000000000007")),
+              "-10000000000000000000000000000000000000007");
+}
+
+TEST(correctness, div_long_recursive)
+{
+    for (size_t divisor_size : {50, 130, 600}) {
+        for (size_t quotient_size : {20, 130, 1300}) {
+            big_integer divisor = rand_big(divisor_size);
+            big_integer quotient = rand_big(quotient_size);
+            big_integer residue = rand_big(divisor_size - 1);
+            big_integer divident = quotient * divisor + residue;
+            EXPECT_EQ(divident / divisor, quotient);
+            EXPECT_EQ(divident % divisor, residue);
+            EXPECT_EQ(-divident / divisor, -quotient);
+        }
+    }
+    big_integer ones = (big_integer(1) << 9000) - 1; // all-ones quotient limbs keep the estimates at their limit
+    big_integer divisor = (big_integer(1) << 4000) - 1;
+    EXPECT_EQ((ones * divisor + divisor - 1) / divisor, ones);
+    EXPECT_EQ(ones * divisor / ones, divisor);
+}
+
+TEST(correctness, short_products)
+{
+    for (size_t size : {3, 30, 100, 400}) {
+        big_integer a = rand_big(size);
+        big_integer b = -rand_big(size);
+        big_integer product = a * b;
+        int n = static_cast<int>(size);
+        for (int bits : {0, 1, 31 * n, 31 * n + 17, 70 * n}) {
+            big_integer mask = (big_integer(1) << bits) - 1;
+            EXPECT_EQ(mul_low(a, b, bits), product & mask);
+            EXPECT_EQ(mul_low(a, a, bits), sqr(a) & mask);
+            EXPECT_EQ(mul_high(a, b, bits), product >> bits);
+            EXPECT_EQ(mul_high(b, b, bits), sqr(b) >> bits);
+        }
+    }
+    EXPECT_EQ(mul_high(-big_integer(1) << 100, big_integer(1) << 100, 200), -1);
+    EXPECT_EQ(mul_high(-big_integer(1) << 100, big_integer(1) << 100, 199), -2);
+    EXPECT_EQ(mul_high(big_integer(3), big_integer(5), -2), 60);
+}
+
+TEST(correctness, reciprocal_newton)
+{
+    for (size_t size : {1, 40, 1000}) {
+        big_integer x = rand_big(size);
+        int n = static_cast<int>(size);
+        for (int bits : {0, 31 * n, 64 * n + 5, 100000}) {
+            big_integer expected = (big_integer(1) << bits) / x;
+            EXPECT_EQ(reciprocal(x, bits), expected);
+            EXPECT_EQ(reciprocal(-x, bits), -expected);
+        }
+    }
+    big_integer pow2 = big_integer(1) << 5000; // exact quotients sit right on the correction boundary
+    EXPECT_EQ(reciprocal(pow2, 90000), big_integer(1) << 85000);
+    EXPECT_EQ(reciprocal(pow2 - 1, 90000) * (pow2 - 1), (big_integer(1) << 90000) - 1);
+    EXPECT_EQ(reciprocal(big_integer(7), -1), 0);
+    EXPECT_THROW(reciprocal(big_integer(0), 10), std::invalid_argument);
+}
+
+TEST(correctness, divmod_signs)
+{
+    big_integer big = (big_integer(1) << 300) + 12345;
+    big_integer mid = big_integer(1) << 100;
+    for (big_integer a : {big_integer(7), big_integer(-7), big, -big, big_integer(0)}) {
+        for (big_integer b : {big_integer(2), big_integer(-2), mid, 3 - mid, big}) {
+            auto [q, r] = divmod(a, b);
+            EXPECT_EQ(q, a / b);
+            EXPECT_EQ(r, a % b);
+            EXPECT_EQ(q * b + r, a);
+            EXPECT_TRUE(r == 0 || (r < 0) == (a < 0));
+            EXPECT_LT(abs(r), abs(b));
+        }
+    }
+    EXPECT_THROW(divmod(big, big_integer(0)), std::invalid_argument);
+}
+
+TEST(correctness, small_divisor)
+{
+    big_integer a = rand_big(200);
+    for (uint64_t value : {uint64_t(1), uint64_t(3), uint64_t(10), uint64_t(1000000007), (uint64_t(1) << 32) - 1,
+                           uint64_t(1) << 32, uint64_t(1) << 63, std::numeric_limits<uint64_t>::max()}) {
+        big_integer::small_divisor d(value);
+        EXPECT_EQ(d.value(), value);
+        for (big_integer x : {a, -a, big_integer(5), big_integer(0), big_integer(-1)}) {
+            auto [q, r] = divmod(x, d);
+            EXPECT_EQ(q, x / value);
+            EXPECT_EQ(r, x % value);
+            EXPECT_EQ(x / d, q);
+            EXPECT_EQ(x % d, r);
+        }
+        big_integer b = a;
+        b /= d;
+        EXPECT_EQ(b, a / value);
+        b %= d;
+        EXPECT_EQ(b, a / value % value);
+    }
+    EXPECT_THROW(big_integer::small_divisor(0), std::invalid_argument);
+}
+
+TEST(correctness, divexact)
+{
+    for (std::pair<size_t, size_t> sizes : {std::make_pair(3, 1), std::make_pair(20, 12), std::make_pair(700, 30),
+                                            std::make_pair(700, 700), std::make_pair(1500, 700)}) {
+        big_integer q = rand_big(sizes.first), b = rand_big(sizes.second);
+        for (big_integer d : {b, b * 2, b << 100, big_integer(1) << 70, big_integer(7) << 3}) {
+            big_integer a = q * d;
+            EXPECT_EQ(divexact(a, d), q);
+            EXPECT_EQ(divexact(-a, d), -q);
+            EXPECT_EQ(divexact(a, -d), -q);
+            EXPECT_EQ(divexact(-a, -d), q);
+            EXPECT_EQ(divexact(a + d, d), q + 1);
+        }
+    }
+    EXPECT_EQ(divexact(big_integer(0), big_integer(5)), 0);
+    EXPECT_THROW(divexact(big_integer(5), big_integer(0)), std::invalid_argument);
+}
+
+TEST(correctness, div_trial_quotient_edges)
+{
+    big_integer one = 1;
+    for (int bits : {64, 96, 128, 200, 1000}) {
+        for (big_integer b : {(one << bits) - 1, (one << (bits - 1)) + (one << (bits - 40)) - 1,
+                              (one << (bits - 1)) + 1, ((one << bits) - 1) / 3}) {
+            for (big_integer q : {(one << 700) - 1, (one << 700) / 3, big_integer(1)}) {
+                for (big_integer r : {big_integer(0), b - 1}) {
+                    big_integer a = q * b + r;
+                    EXPECT_EQ(a / b, q);
+                    EXPECT_EQ(a % b, r);
+                }
+            }
+        }
+    }
+}
+
+TEST(correctness, to_string_divide_and_conquer)
+{
+    for (size_t digits : {18, 19, 20, 38, 1000, 5000, 20001}) {
+        std::string nines(digits, '9'), power = "1" + std::string(digits, '0');
+        std::string inner = "1" + std::string(digits / 2, '0') + "7" + std::string(digits / 3, '0') + "1";
+        for (std::string const& str : {nines, power, inner}) {
+            big_integer x(str);
+            EXPECT_EQ(to_string(x), str);
+            EXPECT_EQ(to_string(-x), "-" + str);
+        }
+        big_integer power_of_ten(power);
+        EXPECT_EQ(to_string(power_of_ten - 1), nines);
+        EXPECT_EQ(to_string(power_of_ten * power_of_ten), "1" + std::string(2 * digits, '0'));
+    }
+    EXPECT_EQ(to_string(big_integer()), "0");
+}
+
+TEST(correctness, from_string_divide_and_conquer)
+{
+    big_integer power = 1;
+    for (size_t digits = 0; digits <= 3000; ++digits, power *= 10) {
+        if (digits % 97 == 0 || digits % 19 == 0 || digits % 9 == 0) {
+            EXPECT_EQ(big_integer("1" + std::string(digits, '0')), power);
+            EXPECT_EQ(big_integer(std::string(digits, '0') + "1" + std::string(digits, '0')), power);
+            EXPECT_EQ(big_integer("-" + std::string(digits + 1, '9')), 1 - power * 10);
+        }
+    }
+    std::string digits = "5";
+    for (size_t i = 0; i < 20000; ++i) {
+        digits += static_cast<char>('0' + (i * 7 + i / 13) % 10);
+    }
+    EXPECT_EQ(to_string(big_integer(digits)), digits);
+    EXPECT_EQ(big_integer("-"), 0);
+}
+
+TEST(correctness, radix_conversions)
+{
+    EXPECT_EQ(to_string(big_integer(255), 16), "ff");
+    EXPECT_EQ(to_string(big_integer(-255), 2), "-11111111");
+    EXPECT_EQ(to_string(big_integer(0), 32), "0");
+    EXPECT_EQ(to_string(big_integer(35), 36), "z");
+    EXPECT_EQ(big_integer("-FfFf", 16), -65535);
+    EXPECT_EQ(big_integer("zz", 36), 35 * 36 + 35);
+    EXPECT_EQ(big_integer("0000101", 2), 5);
+    EXPECT_EQ(big_integer("1" + std::string(40, '0'), 16), big_integer(1) << 160);
+    EXPECT_EQ(to_string((big_integer(1) << 160) - 1, 32), std::string(32, 'v'));
+
+    big_integer x = rand_big(800);
+    for (int radix = 2; radix <= 36; ++radix) {
+        for (big_integer const& value : {x, -x, x * x, big_integer(radix), big_integer(radix - 1)}) {
+            EXPECT_EQ(big_integer(to_string(value, radix), radix), value);
+        }
+    }
+    EXPECT_EQ(to_string(x, 10), to_string(x));
+    EXPECT_THROW(big_integer("12", 1), std::invalid_argument);
+    EXPECT_THROW(big_integer("12", 37), std::invalid_argument);
+    EXPECT_THROW(big_integer("129", 9), std::invalid_argument);
+    EXPECT_THROW(big_integer("1g", 16), std::invalid_argument);
+    EXPECT_THROW(to_string(x, 0), std::invalid_argument);
+}
+
+TEST(correctness, to_chars_from_chars)
+{
+    big_integer x = rand_big(300);
+    for (int base : {2, 10, 16, 36}) {
+        for (big_integer const& value : {x, -x, big_integer(0), big_integer(-1), x * x * x}) {
+            std::string expected = to_string(value, base);
+            std::vector<char> buf(to_chars_bound(value, base));
+            ASSERT_GE(buf.size(), expected.size());
+            std::to_chars_result res = to_chars(buf.data(), buf.data() + buf.size(), value, base);
+            EXPECT_EQ(res.ec, std::errc());
+            EXPECT_EQ(std::string(buf.data(), res.ptr), expected);
+
+            res = to_chars(buf.data(), buf.data() + expected.size(), value, base);
+            EXPECT_EQ(res.ec, std::errc());
+            EXPECT_EQ(res.ptr, buf.data() + expected.size());
+            res = to_chars(buf.data(), buf.data() + expected.size() - 1, value, base);
+            EXPECT_EQ(res.ec, std::errc::value_too_large);
+            EXPECT_EQ(res.ptr, buf.data() + expected.size() - 1);
+
+            std::string text = expected + " rest";
+            big_integer parsed;
+            std::from_chars_result parse = from_chars(text.data(), text.data() + text.size(), parsed, base);
+            EXPECT_EQ(parse.ec, std::errc());
+            EXPECT_EQ(parse.ptr, text.data() + expected.size());
+            EXPECT_EQ(parsed, value);
+        }
+    }
+    big_integer untouched = 42;
+    std::string text = "-x";
+    std::from_chars_result parse = from_chars(text.data(), text.data() + text.size(), untouched);
+    EXPECT_EQ(parse.ec, std::errc::invalid_argument);
+    EXPECT_EQ(parse.ptr, text.data());
+    EXPECT_EQ(untouched, 42);
+    text = "-12z";
+    parse = from_chars(text.data(), text.data() + text.size(), untouched);
+    EXPECT_EQ(parse.ptr, text.data() + 3);
+    EXPECT_EQ(untouched, -12);
+}
+
+TEST(correctness, decimal_validation_blocks)
+{
+    std::string digits;
+    for (size_t i = 0; i < 100; ++i) {
+        digits += static_cast<char>('0' + (i * 3 + 1) % 10);
+    }
+    big_integer value(digits);
+    for (char bad : {'/', ':', ' ', 'a', '\x80', '\xff', '\0'}) {
+        for (size_t pos = 0; pos < digits.size(); pos += 7) {
+            std::string text = digits;
+            text[pos] = bad;
+            EXPECT_THROW(big_integer{text}, std::invalid_argument);
+            big_integer parsed;
+            std::from_chars_result res = from_chars(text.data(), text.data() + text.size(), parsed);
+            EXPECT_EQ(res.ptr, text.data() + pos);
+            if (pos) {
+                EXPECT_EQ(parsed, big_integer(digits.substr(0, pos)));
+            }
+        }
+    }
+    EXPECT_EQ(to_string(value), digits);
+}
+
+TEST(correctness, stream_round_trip)
+{
+    std::vector<big_integer> values;
+    for (size_t len : {1, 19, 700, 1216, 2433, 5000, 30000}) {
+        std::string digits;
+        for (size_t i = 0; i < len; ++i) {
+            digits += static_cast<char>('0' + (i * 7 + len) % 10);
+        }
+        digits[0] = '7';
+        values.emplace_back(digits);
+        values.push_back(-values.back());
+    }
+    std::stringstream stream;
+    for (big_integer const& value : values) {
+        stream << value << ' ';
+    }
+    for (big_integer const& value : values) {
+        EXPECT_EQ(stream.str().find(to_string(value) + ' ') != std::string::npos, true);
+    }
+    for (big_integer const& value : values) {
+        big_integer read;
+        EXPECT_TRUE(static_cast<bool>(stream >> read));
+        EXPECT_EQ(read, value);
+    }
+    big_integer read;
+    EXPECT_FALSE(static_cast<bool>(stream >> read));
+    EXPECT_TRUE(stream.eof());
+
+    std::istringstream text("  0012 -x 5");
+    EXPECT_TRUE(static_cast<bool>(text >> read));
+    EXPECT_EQ(read, 12);
+    EXPECT_FALSE(static_cast<bool>(text >> read));
+    EXPECT_FALSE(text.eof());
+    std::istringstream plus("+5");
+    EXPECT_FALSE(static_cast<bool>(plus >> read)); // as the string constructor
+    EXPECT_THROW(big_integer("+5"), std::invalid_argument);
+
+    big_integer wide = (big_integer(1) << 3000) - 12345;
+    std::istringstream radices("-ff7Ag 777 " + to_string(wide, 16) + ' ' + to_string(-wide, 8));
+    radices >> std::hex;
+    EXPECT_TRUE(static_cast<bool>(radices >> read));
+    EXPECT_EQ(read, -0xff7a);
+    EXPECT_EQ(radices.peek(), 'g');
+    radices.ignore();
+    EXPECT_TRUE(static_cast<bool>(radices >> read));
+    EXPECT_EQ(read, 0x777);
+    EXPECT_TRUE(static_cast<bool>(radices >> read));
+    EXPECT_EQ(read, wide);
+    EXPECT_TRUE(static_cast<bool>(radices >> std::oct >> read));
+    EXPECT_EQ(read, -wide);
+
+    big_integer huge = rand_big(100);
+    for (int i = 0; i < 10; ++i) {
+        huge = huge * huge + i; // about 3 million bits
+    }
+    std::vector<big_integer> powers_of_two = {huge, -(huge >> 7), (big_integer(1) << 4 * 4096 * 3) - 1, -huge};
+    std::stringstream blocks;
+    blocks << std::hex;
+    for (size_t i = 0; i + 1 < powers_of_two.size(); ++i) {
+        blocks << to_string(powers_of_two[i], 16) << ' ';
+    }
+    blocks << to_string(powers_of_two.back(), 8);
+    for (size_t i = 0; i < powers_of_two.size(); ++i) {
+        EXPECT_TRUE(static_cast<bool>(i + 1 < powers_of_two.size() ? blocks >> read : blocks >> std::oct >> read));
+        EXPECT_EQ(read, powers_of_two[i]);
+    }
+    EXPECT_TRUE(blocks.eof());
+
+    std::ostringstream padded;
+    padded << std::setw(6) << big_integer(-42);
+    EXPECT_EQ(padded.str(), "   -42");
+}
+
+TEST(correctness, binary_serialization)
+{
+    std::vector<big_integer> values = {0, 1, -1, 63, -64, 64, std::numeric_limits<int32_t>::min()};
+    big_integer two_63 = big_integer(1) << 63;
+    big_integer decimal("12345678901234567890123");
+    for (big_integer base : {two_63, big_integer(1) << 64, big_integer(1) << 200, decimal}) {
+        for (int delta : {-1, 0, 1}) {
+            values.push_back(base + delta);
+            values.push_back(-base + delta);
+        }
+    }
+    values.push_back(big_integer(std::string(3000, '7')));
+    values.push_back(-values.back());
+    std::vector<unsigned char> bytes;
+    for (big_integer const& value : values) {
+        size_t size = serialized_size(value);
+        bytes.assign(size + 3, 0xee);
+        serialize_result res = serialize(bytes.data(), bytes.data() + size, value);
+        ASSERT_EQ(res.ec, std::errc());
+        EXPECT_EQ(res.ptr, bytes.data() + size);
+        EXPECT_EQ(bytes[size], 0xee);
+        EXPECT_EQ(bytes[0] & 0xf, value >= -two_63 && value < two_63 ? 0 : value < 0 ? 3 : 2);
+        big_integer read = 42;
+        deserialize_result back = deserialize(bytes.data(), bytes.data() + bytes.size(), read);
+        EXPECT_EQ(back.ec, std::errc());
+        EXPECT_EQ(back.ptr, bytes.data() + size);
+        EXPECT_EQ(read, value);
+        EXPECT_EQ(serialize(bytes.data(), bytes.data() + size - 1, value).ec, std::errc::value_too_large);
+        for (size_t len = 0; len < size; len += size / 7 + 1) {
+            EXPECT_EQ(deserialize(bytes.data(), bytes.data() + len, read).ec, std::errc::invalid_argument);
+            EXPECT_EQ(read, value);
+        }
+    }
+    // the same bytes for either limb width
+    std::vector<unsigned char> expected = {0x12, 9, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+    bytes.resize(serialized_size(big_integer(1) << 64));
+    serialize(bytes.data(), bytes.data() + bytes.size(), big_integer(1) << 64);
+    EXPECT_EQ(bytes, expected);
+    expected = {0x10, 0x81, 0x01};
+    bytes.resize(serialized_size(-65));
+    serialize(bytes.data(), bytes.data() + bytes.size(), -65);
+    EXPECT_EQ(bytes, expected);
+    expected[0] = 0x20;
+    big_integer untouched = 5;
+    EXPECT_EQ(deserialize(expected.data(), expected.data() + expected.size(), untouched).ec, std::errc::not_supported);
+    EXPECT_EQ(untouched, 5);
+}
+
+TEST(correctness, view_operations)
+{
+    using limb_t = big_integer_view::limb_t;
+    std::vector<limb_t> limbs(300);
+    for (size_t i = 0; i < limbs.size(); ++i) {
+        limbs[i] = static_cast<limb_t>(i * 0x9e3779b97f4a7c15ull + 1);
+    }
+    limbs.push_back(0); // leading zeros are ignored
+    big_integer owned;
+    for (size_t i = limbs.size(); i--;) {
+        owned = (owned << static_cast<int>(sizeof(limb_t) * 8)) + static_cast<uint64_t>(limbs[i]);
+    }
+    std::vector<big_integer> others = {0, 1, -7, big_integer("123456789012345678901234567890"), owned, -owned + 1};
+    for (size_t n : {0, 1, 2, 40, 301}) {
+        big_integer value = owned % (big_integer(1) << static_cast<int>(n * sizeof(limb_t) * 8));
+        for (bool negative : {false, true}) {
+            big_integer_view view(limbs.data(), n, negative);
+            big_integer expected = negative ? -value : value;
+            EXPECT_EQ(big_integer(view), expected);
+            EXPECT_EQ(to_string(view), to_string(expected));
+            EXPECT_EQ(to_string(view, 16), to_string(expected, 16));
+            EXPECT_EQ(to_string(view, 7), to_string(expected, 7));
+            for (big_integer const& other : others) {
+                EXPECT_EQ(view + other, expected + other);
+                EXPECT_EQ(other - view, other - expected);
+                EXPECT_EQ(view * other, expected * other);
+                EXPECT_EQ(view == other, expected == other);
+                EXPECT_EQ(view < other, expected < other);
+                EXPECT_EQ(other >= view, other >= expected);
+                if (other != 0) {
+                    EXPECT_EQ(divmod(view, other), divmod(expected, other));
+                }
+                if (expected != 0) {
+                    EXPECT_EQ(other / view, other / expected);
+                    EXPECT_EQ(other % view, other % expected);
+                }
+            }
+            for (int bits : {0, 1, 63, 64, 65, 1000, 20000}) {
+                EXPECT_EQ(view << bits, expected << bits);
+                EXPECT_EQ(view >> bits, expected >> bits);
+            }
+            EXPECT_EQ(view - view, 0);
+        }
+    }
+    EXPECT_THROW(big_integer(1) / big_integer_view(limbs.data(), 0), std::invalid_argument);
+
+    std::vector<uint32_t> words(102); // 32-bit words as mapped from a file, whatever the limb width
+    for (size_t i = 0; i < words.size(); ++i) {
+        words[i] = static_cast<uint32_t>(i * 0x9e3779b9u + 5);
+    }
+    for (size_t offset : {0, 1}) {
+        for (size_t n : {0, 1, 2, 7, 100, 101}) {
+            big_integer value;
+            for (size_t i = n; i--;) {
+                value = (value << 32) + words[offset + i];
+            }
+            for (bool negative : {false, true}) {
+                big_integer_view view(words.data() + offset, n, negative);
+                big_integer expected = negative ? -value : value;
+                EXPECT_EQ(big_integer(view), expected);
+                EXPECT_EQ(to_string(view, 16), to_string(expected, 16));
+                EXPECT_EQ(view * owned, expected * owned);
+                EXPECT_EQ(view - owned, expected - owned);
+                EXPECT_EQ(view == expected, true);
+            }
+        }
+    }
+}
+
+TEST(correctness, order_preserving_keys)
+{
+    std::vector<big_integer> values = {0, 1, -1, 255, 256, -255, -256, big_integer(1) << 64, -(big_integer(1) << 64)};
+    for (int bits : {7, 8, 31, 32, 63, 64, 65, 200, 2050}) {
+        big_integer base = big_integer(1) << bits;
+        for (int delta : {-3, -1, 0, 1, 2}) {
+            values.push_back(base + delta);
+            values.push_back(-base + delta);
+            values.push_back(base / 3 + delta);
+            values.push_back(-base / 3 + delta);
+        }
+    }
+    std::vector<std::vector<unsigned char>> keys;
+    for (big_integer const& value : values) {
+        std::vector<unsigned char> key(key_size(value));
+        serialize_result res = encode_key(key.data(), key.data() + key.size(), value);
+        ASSERT_EQ(res.ec, std::errc());
+        EXPECT_EQ(res.ptr, key.data() + key.size());
+        EXPECT_EQ(encode_key(key.data(), key.data() + key.size() - 1, value).ec, std::errc::value_too_large);
+        big_integer read = 42;
+        deserialize_result back = decode_key(key.data(), key.data() + key.size(), read);
+        EXPECT_EQ(back.ec, std::errc());
+        EXPECT_EQ(back.ptr, key.data() + key.size());
+        EXPECT_EQ(read, value);
+        EXPECT_EQ(decode_key(key.data(), key.data() + key.size() - 1, read).ec, std::errc::invalid_argument);
+        keys.push_back(key);
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (size_t j = 0; j < values.size(); ++j) {
+            size_t len = std::min(keys[i].size(), keys[j].size());
+            int order = std::memcmp(keys[i].data(), keys[j].data(), len);
+            EXPECT_EQ(order < 0, values[i] < values[j]);
+            EXPECT_EQ(order == 0, values[i] == values[j]);
+        }
+    }
+    // the same bytes for either limb width
+    std::vector<unsigned char> expected = {0x81, 9, 1, 0, 0, 0, 0, 0, 0, 0, 0};
+    EXPECT_EQ(keys[7], expected);
+    expected = {0x7f, 0xf6, 0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    EXPECT_EQ(keys[8], expected);
+}
+
+namespace {
+template<typename Limb>
+std::vector<Limb> rand_limbs(size_t n)
+{
+    std::vector<Limb> res(n);
+    for (Limb& limb : res) { // long runs of all-ones and zero limbs push carries through whole vectors
+        int kind = rand() % 4;
+        uint64_t bits = (uint64_t(rand()) << 40) ^ (uint64_t(rand()) << 20) ^ rand();
+        limb = kind == 0 ? Limb(-1) : kind == 1 ? 0 : static_cast<Limb>(bits);
+    }
+    return res;
+}
+
+// every kernel set the running CPU supports against plain loops with the same contracts
+template<typename Limb>
+void check_simd_kernels()
+{
+    for (simd_level level : {simd_level::none, simd_level::avx2, simd_level::avx512}) {
+        if (level > simd_kernels<Limb>::detect()) {
+            break;
+        }
+        simd_kernels<Limb> const& kernels = simd_kernels<Limb>::select(level);
+        for (size_t n : {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 32, 33, 64, 100}) {
+            std::vector<Limb> a = rand_limbs<Limb>(n), b = rand_limbs<Limb>(n), res(n), expected(n);
+            Limb val = n % 2 ? Limb(-1) : static_cast<Limb>(rand());
+            if (kernels.add_n) {
+                Limb carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    Limb sum = a[i] + carry;
+                    Limb next = sum < carry;
+                    expected[i] = sum + b[i];
+                    carry = next + (expected[i] < sum);
+                }
+                EXPECT_EQ(kernels.add_n(res.data(), a.data(), b.data(), n), carry);
+                EXPECT_EQ(res, expected);
+            }
+            if (kernels.sub_n) {
+                Limb borrow = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    Limb diff = a[i] - borrow;
+                    Limb next = a[i] < borrow;
+                    expected[i] = diff - b[i];
+                    borrow = next + (diff < b[i]);
+                }
+                EXPECT_EQ(kernels.sub_n(res.data(), a.data(), b.data(), n), borrow);
+                EXPECT_EQ(res, expected);
+            }
+            auto check_bitwise = [&](auto kernel, auto op) {
+                if (kernel) {
+                    for (size_t i = 0; i < n; ++i) {
+                        expected[i] = op(a[i], b[i]);
+                    }
+                    kernel(res.data(), a.data(), b.data(), n);
+                    EXPECT_EQ(res, expected);
+                }
+            };
+            check_bitwise(kernels.and_n, [](Limb x, Limb y) { return Limb(x & y); });
+            check_bitwise(kernels.or_n, [](Limb x, Limb y) { return Limb(x | y); });
+            check_bitwise(kernels.xor_n, [](Limb x, Limb y) { return Limb(x ^ y); });
+            if (kernels.com_n) {
+                for (size_t i = 0; i < n; ++i) {
+                    expected[i] = ~a[i];
+                }
+                kernels.com_n(res.data(), a.data(), n);
+                EXPECT_EQ(res, expected);
+            }
+            std::vector<Limb> ones(n, Limb(-1)); // every column at its maximum
+            for (bool accumulate : {false, true}) {
+                auto kernel = accumulate ? kernels.addmul_1 : kernels.mul_1;
+                if (!kernel) {
+                    continue;
+                }
+                __extension__ typedef unsigned __int128 uint128_t; // holds a product of two limbs of either width
+                for (auto [x, y] : {std::pair(&a, &b), std::pair(&ones, &ones)}) {
+                    Limb carry = 0;
+                    for (size_t i = 0; i < n; ++i) {
+                        uint128_t t = static_cast<uint128_t>((*x)[i]) * val + carry + (accumulate ? (*y)[i] : 0);
+                        expected[i] = static_cast<Limb>(t);
+                        carry = static_cast<Limb>(t >> sizeof(Limb) * 8);
+                    }
+                    res = *y;
+                    EXPECT_EQ(kernel(res.data(), x->data(), n, val), carry);
+                    EXPECT_EQ(res, expected);
+                }
+            }
+        }
+        if (kernels.digit_span) {
+            std::string digits(100, '0');
+            for (char& ch : digits) {
+                ch = static_cast<char>('0' + rand() % 10);
+            }
+            EXPECT_EQ(kernels.digit_span(digits.data(), digits.size()), digits.size());
+            for (char bad : {'/', ':', ' ', 'a', '\x80', '\0'}) {
+                for (size_t pos = 0; pos < digits.size(); pos += 9) {
+                    std::string text = digits;
+                    text[pos] = bad;
+                    size_t len = text.size() - pos % 5;
+                    EXPECT_EQ(kernels.digit_span(text.data(), len), std::min(pos, len));
+                }
+            }
+        }
+        if (kernels.decimal_chunks) {
+            size_t const digits = sizeof(Limb) == 8 ? 19 : 9;
+            std::string text(digits * 13, '0');
+            for (char& ch : text) {
+                ch = static_cast<char>('0' + rand() % 10);
+            }
+            text.replace(0, digits, std::string(digits, '9'));
+            std::vector<Limb> res(13), expected(13);
+            for (size_t i = 0; i < 13; ++i) {
+                for (size_t j = 0; j < digits; ++j) {
+                    expected[i] = expected[i] * 10 + (text[i * digits + j] - '0');
+                }
+            }
+            kernels.decimal_chunks(res.data(), text.data(), 13);
+            EXPECT_EQ(res, expected);
+        }
+    }
+}
+}
+
+TEST(correctness, simd_kernels_every_level)
+{
+    check_simd_kernels<uint32_t>();
+    check_simd_kernels<uint64_t>();
+}
+
+TEST(correctness, radix_powers_from_threads)
+{
+    big_integer x = rand_big(400);
+    std::vector<std::string> texts(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        threads.emplace_back([&, i] { texts[i] = to_string(x >> (i * 997), 23 + i % 2); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (size_t i = 0; i < texts.size(); ++i) {
+        EXPECT_EQ(big_integer(texts[i], 23 + i % 2), x >> (i * 997));
+    }
+}
+
+TEST(correctness, mul_parallel_callers)
+{
+    std::vector<big_integer> values, expected, parallel(6); // more callers than the pool has queues for
+    for (size_t i = 0; i < parallel.size(); ++i) {
+        values.push_back(rand_big(2200 + 100 * i)); // past parallel_threshold
+        expected.push_back(values[i] * (values[i] + 1));
+    }
+    big_integer::set_multiplication_threads(3);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < parallel.size(); ++i) {
+        threads.emplace_back([&, i] { parallel[i] = values[i] * (values[i] + 1); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    big_integer::set_multiplication_threads(1);
+    EXPECT_TRUE(parallel == expected);
+}
+
+TEST(correctness, view_of_negative_values)
+{
+    using limb_t = big_integer_view::limb_t;
+    int const limb_bits = static_cast<int>(sizeof(limb_t) * 8);
+    limb_t const max = std::numeric_limits<limb_t>::max();
+    std::vector<std::vector<limb_t>> magnitudes = {{}, {1}, {2}, {0, 1}, {max}, {1, max}, {0, 0, 1}, {max, max, max},
+                                                   {limb_t(1) << (limb_bits - 1)}, {0, limb_t(1) << (limb_bits - 1)}};
+    magnitudes.emplace_back(700);
+    for (size_t i = 0; i < 700; ++i) {
+        magnitudes.back()[i] = static_cast<limb_t>(i * 0x9e3779b97f4a7c15ull + 3);
+    }
+    magnitudes.push_back(magnitudes.back());
+    magnitudes.back().insert(magnitudes.back().begin(), 3, 0);
+    std::vector<big_integer> values;
+    std::vector<big_integer_view> plain; // the same values, as sign and magnitude
+    for (std::vector<limb_t> const& magnitude : magnitudes) {
+        big_integer value;
+        for (size_t i = magnitude.size(); i--;) {
+            value = (value << limb_bits) + static_cast<uint64_t>(magnitude[i]);
+        }
+        for (bool negative : {false, true}) {
+            values.push_back(negative ? -value : value);
+            plain.emplace_back(magnitude.data(), magnitude.size(), negative);
+        }
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        big_integer const& value = values[i];
+        big_integer_view view(value);
+        EXPECT_EQ(big_integer(view), value);
+        EXPECT_EQ(big_integer(plain[i]), value);
+        EXPECT_EQ(abs(view), abs(value));
+        EXPECT_EQ(to_string(view), to_string(value));
+        EXPECT_EQ(to_string(view, 3), to_string(value, 3));
+        EXPECT_EQ(to_string(view, 32), to_string(value, 32));
+        EXPECT_EQ(bit_length(view), bit_length(plain[i]));
+        EXPECT_EQ(bit_length(view) == 0, value == 0);
+        if (value != 0) {
+            EXPECT_EQ(abs(value) >> static_cast<int>(bit_length(value) - 1), 1);
+        }
+        for (size_t index : {0, 1, 31, 63, 64, 65, 200, 5000, 30000}) {
+            bool expected = (value >> static_cast<int>(index)) % 2 != 0;
+            EXPECT_EQ(bit_test(view, index), expected);
+            EXPECT_EQ(bit_test(plain[i], index), expected);
+        }
+        for (size_t j = 0; j < values.size(); ++j) {
+            big_integer const& other = values[j];
+            EXPECT_EQ(view + other, value + other);
+            EXPECT_EQ(view - other, value - other);
+            EXPECT_EQ(plain[i] - other, value - other);
+            EXPECT_EQ(view + plain[j], value + other);
+            EXPECT_EQ(view * other, value * other);
+            EXPECT_EQ(plain[i] * other, value * other);
+            EXPECT_EQ(view < other, value < other);
+            EXPECT_EQ(plain[i] == other, value == other);
+            EXPECT_EQ(view >= plain[j], value >= other);
+            if (other != 0) {
+                EXPECT_EQ(divmod(view, other), divmod(value, other));
+                EXPECT_EQ(divmod(view, plain[j]), divmod(value, other));
+            }
+        }
+        for (int bits : {0, 1, 63, 64, 65, 1000, 30000}) {
+            EXPECT_EQ(view << bits, value << bits);
+            EXPECT_EQ(view >> bits, value >> bits);
+        }
+        EXPECT_EQ(view == 0, value == 0);
+        EXPECT_EQ(-3 < view, -3 < value);
+        EXPECT_EQ(view * 2, value * 2);
+        EXPECT_EQ(view * -7LL, value * -7LL);
+        EXPECT_EQ(5u - view, 5u - value);
+        EXPECT_EQ(view + INT64_MIN, value + INT64_MIN);
+        EXPECT_EQ(view / 10, value / 10);
+        EXPECT_EQ(view % -10, value % -10);
+        if (value != 0) {
+            EXPECT_EQ(UINT64_MAX % view, UINT64_MAX % value);
+        }
+    }
+}
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <limits>
 
 template<typename T>
 dynamic_storage<T>::big_data::deleter::deleter() = default;
@@ -0,0 +1,545 @@
+#include "simd_kernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SIMD_KERNELS_X86
+// GCC 12 flags the _mm512_undefined_* placeholders inside the AVX-512 intrinsics as maybe-uninitialized once they
+// are inlined at -O2 and above, a false positive (GCC bug 105593, fixed in GCC 13)
+#ifndef __clang__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#ifndef __clang__
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+namespace {
+template<typename Limb>
+Limb add_tail(Limb* res, Limb const* a, Limb const* b, size_t n, Limb carry)
+{
+    for (size_t i = 0; i < n; ++i) {
+        Limb x = a[i], s = x + b[i];
+        Limb overflow = s < x;
+        res[i] = s + carry;
+        carry = overflow + (res[i] < s);
+    }
+    return carry;
+}
+
+template<typename Limb>
+Limb sub_tail(Limb* res, Limb const* a, Limb const* b, size_t n, Limb borrow)
+{
+    for (size_t i = 0; i < n; ++i) {
+        Limb x = a[i], y = b[i], d = x - y;
+        Limb underflow = x < y;
+        res[i] = d - borrow;
+        borrow = underflow + (d < borrow);
+    }
+    return borrow;
+}
+
+uint32_t mul_tail(uint32_t* res, uint32_t const* a, size_t n, uint32_t val, uint32_t carry, bool accumulate)
+{
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t tmp = static_cast<uint64_t>(a[i]) * val + (accumulate ? res[i] : 0) + carry;
+        res[i] = static_cast<uint32_t>(tmp);
+        carry = static_cast<uint32_t>(tmp >> 32);
+    }
+    return carry;
+}
+
+uint64_t mul_tail(uint64_t* res, uint64_t const* a, size_t n, uint64_t val, uint64_t carry, bool accumulate)
+{
+    __extension__ typedef unsigned __int128 uint128_t;
+    for (size_t i = 0; i < n; ++i) {
+        uint128_t tmp = static_cast<uint128_t>(a[i]) * val + (accumulate ? res[i] : 0) + carry;
+        res[i] = static_cast<uint64_t>(tmp);
+        carry = static_cast<uint64_t>(tmp >> 64);
+    }
+    return carry;
+}
+
+// Carries between lanes are resolved on bit masks: g marks lanes that overflow by themselves, p marks lanes that
+// overflow only when a carry comes in, and ((g << 1 | carry) + p) ^ p marks the lanes a carry comes into.
+
+#ifdef SIMD_KERNELS_X86
+#define SIMD_AVX2 __attribute__((target("avx2")))
+#define SIMD_AVX512 __attribute__((target("avx512f")))
+#define SIMD_AVX512IFMA __attribute__((target("avx512f,avx512ifma")))
+
+template<typename Limb>
+SIMD_AVX2 __m256i load(Limb const* p)
+{
+    return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+}
+
+template<typename Limb>
+SIMD_AVX2 void store(Limb* p, __m256i x)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x);
+}
+
+SIMD_AVX2 unsigned lanes(__m256i mask) // one bit per 32-bit lane
+{
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+}
+
+SIMD_AVX2 unsigned lanes64(__m256i mask) // one bit per 64-bit lane
+{
+    return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+}
+
+SIMD_AVX2 __m256i expand(unsigned bits) // -1 in the 32-bit lanes selected by bits
+{
+    __m256i const select = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits)), select), select);
+}
+
+SIMD_AVX2 __m256i expand64(unsigned bits) // -1 in the 64-bit lanes selected by bits
+{
+    __m256i const select = _mm256_setr_epi64x(1, 2, 4, 8);
+    return _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(bits), select), select);
+}
+
+SIMD_AVX2 uint32_t add_n_avx2(uint32_t* res, uint32_t const* a, uint32_t const* b, size_t n)
+{
+    __m256i const ones = _mm256_set1_epi32(-1);
+    unsigned carry = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = load(a + i);
+        __m256i s = _mm256_add_epi32(x, load(b + i));
+        unsigned g = ~lanes(_mm256_cmpeq_epi32(_mm256_max_epu32(s, x), s)) & 0xFF; // s < x
+        unsigned p = lanes(_mm256_cmpeq_epi32(s, ones));
+        unsigned t = ((g << 1) | carry) + p;
+        carry = t >> 8;
+        store(res + i, _mm256_sub_epi32(s, expand(t ^ p)));
+    }
+    return add_tail<uint32_t>(res + i, a + i, b + i, n - i, carry);
+}
+
+SIMD_AVX2 uint32_t sub_n_avx2(uint32_t* res, uint32_t const* a, uint32_t const* b, size_t n)
+{
+    unsigned borrow = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = load(a + i), y = load(b + i);
+        __m256i d = _mm256_sub_epi32(x, y);
+        unsigned g = ~lanes(_mm256_cmpeq_epi32(_mm256_max_epu32(x, y), x)) & 0xFF; // x < y
+        unsigned p = lanes(_mm256_cmpeq_epi32(d, _mm256_setzero_si256()));
+        unsigned t = ((g << 1) | borrow) + p;
+        borrow = t >> 8;
+        store(res + i, _mm256_add_epi32(d, expand(t ^ p)));
+    }
+    return sub_tail<uint32_t>(res + i, a + i, b + i, n - i, borrow);
+}
+
+// AVX2 has no unsigned 64-bit comparison, flipping the sign bits turns the signed one into it
+SIMD_AVX2 __m256i less64(__m256i x, __m256i y)
+{
+    __m256i const sign = _mm256_set1_epi64x(INT64_MIN);
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(y, sign), _mm256_xor_si256(x, sign));
+}
+
+SIMD_AVX2 uint64_t add_n_avx2(uint64_t* res, uint64_t const* a, uint64_t const* b, size_t n)
+{
+    __m256i const ones = _mm256_set1_epi64x(-1);
+    unsigned carry = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = load(a + i);
+        __m256i s = _mm256_add_epi64(x, load(b + i));
+        unsigned g = lanes64(less64(s, x));
+        unsigned p = lanes64(_mm256_cmpeq_epi64(s, ones));
+        unsigned t = ((g << 1) | carry) + p;
+        carry = t >> 4;
+        store(res + i, _mm256_sub_epi64(s, expand64(t ^ p)));
+    }
+    return add_tail<uint64_t>(res + i, a + i, b + i, n - i, carry);
+}
+
+SIMD_AVX2 uint64_t sub_n_avx2(uint64_t* res, uint64_t const* a, uint64_t const* b, size_t n)
+{
+    unsigned borrow = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = load(a + i), y = load(b + i);
+        __m256i d = _mm256_sub_epi64(x, y);
+        unsigned g = lanes64(less64(x, y));
+        unsigned p = lanes64(_mm256_cmpeq_epi64(d, _mm256_setzero_si256()));
+        unsigned t = ((g << 1) | borrow) + p;
+        borrow = t >> 4;
+        store(res + i, _mm256_add_epi64(d, expand64(t ^ p)));
+    }
+    return sub_tail<uint64_t>(res + i, a + i, b + i, n - i, borrow);
+}
+
+struct and_op {
+    template<typename Limb>
+    Limb operator()(Limb x, Limb y) const { return x & y; }
+    SIMD_AVX2 __m256i operator()(__m256i x, __m256i y) const { return _mm256_and_si256(x, y); }
+    SIMD_AVX512 __m512i operator()(__m512i x, __m512i y) const { return _mm512_and_si512(x, y); }
+};
+
+struct or_op {
+    template<typename Limb>
+    Limb operator()(Limb x, Limb y) const { return x | y; }
+    SIMD_AVX2 __m256i operator()(__m256i x, __m256i y) const { return _mm256_or_si256(x, y); }
+    SIMD_AVX512 __m512i operator()(__m512i x, __m512i y) const { return _mm512_or_si512(x, y); }
+};
+
+struct xor_op {
+    template<typename Limb>
+    Limb operator()(Limb x, Limb y) const { return x ^ y; }
+    SIMD_AVX2 __m256i operator()(__m256i x, __m256i y) const { return _mm256_xor_si256(x, y); }
+    SIMD_AVX512 __m512i operator()(__m512i x, __m512i y) const { return _mm512_xor_si512(x, y); }
+};
+
+template<typename Op, typename Limb>
+SIMD_AVX2 void bitwise_avx2(Limb* res, Limb const* a, Limb const* b, size_t n)
+{
+    size_t const step = sizeof(__m256i) / sizeof(Limb);
+    size_t i = 0;
+    for (; i + step <= n; i += step) {
+        store(res + i, Op()(load(a + i), load(b + i)));
+    }
+    for (; i < n; ++i) {
+        res[i] = Op()(a[i], b[i]);
+    }
+}
+
+template<typename Limb>
+SIMD_AVX2 void com_n_avx2(Limb* res, Limb const* a, size_t n)
+{
+    size_t const step = sizeof(__m256i) / sizeof(Limb);
+    __m256i const ones = _mm256_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + step <= n; i += step) {
+        store(res + i, _mm256_xor_si256(load(a + i), ones));
+    }
+    for (; i < n; ++i) {
+        res[i] = ~a[i];
+    }
+}
+
+SIMD_AVX512 uint32_t add_n_avx512(uint32_t* res, uint32_t const* a, uint32_t const* b, size_t n)
+{
+    __m512i const ones = _mm512_set1_epi32(-1);
+    unsigned carry = 0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i x = _mm512_loadu_si512(a + i);
+        __m512i s = _mm512_add_epi32(x, _mm512_loadu_si512(b + i));
+        unsigned g = _mm512_cmplt_epu32_mask(s, x);
+        unsigned p = _mm512_cmpeq_epi32_mask(s, ones);
+        unsigned t = ((g << 1) | carry) + p;
+        carry = t >> 16;
+        _mm512_storeu_si512(res + i, _mm512_mask_sub_epi32(s, static_cast<__mmask16>(t ^ p), s, ones));
+    }
+    return add_tail<uint32_t>(res + i, a + i, b + i, n - i, carry);
+}
+
+SIMD_AVX512 uint32_t sub_n_avx512(uint32_t* res, uint32_t const* a, uint32_t const* b, size_t n)
+{
+    __m512i const ones = _mm512_set1_epi32(-1);
+    unsigned borrow = 0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i x = _mm512_loadu_si512(a + i), y = _mm512_loadu_si512(b + i);
+        __m512i d = _mm512_sub_epi32(x, y);
+        unsigned g = _mm512_cmplt_epu32_mask(x, y);
+        unsigned p = _mm512_cmpeq_epi32_mask(d, _mm512_setzero_si512());
+        unsigned t = ((g << 1) | borrow) + p;
+        borrow = t >> 16;
+        _mm512_storeu_si512(res + i, _mm512_mask_add_epi32(d, static_cast<__mmask16>(t ^ p), d, ones));
+    }
+    return sub_tail<uint32_t>(res + i, a + i, b + i, n - i, borrow);
+}
+
+SIMD_AVX512 uint64_t add_n_avx512(uint64_t* res, uint64_t const* a, uint64_t const* b, size_t n)
+{
+    __m512i const ones = _mm512_set1_epi64(-1);
+    unsigned carry = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512(a + i);
+        __m512i s = _mm512_add_epi64(x, _mm512_loadu_si512(b + i));
+        unsigned g = _mm512_cmplt_epu64_mask(s, x);
+        unsigned p = _mm512_cmpeq_epi64_mask(s, ones);
+        unsigned t = ((g << 1) | carry) + p;
+        carry = t >> 8;
+        _mm512_storeu_si512(res + i, _mm512_mask_sub_epi64(s, static_cast<__mmask8>(t ^ p), s, ones));
+    }
+    return add_tail<uint64_t>(res + i, a + i, b + i, n - i, carry);
+}
+
+SIMD_AVX512 uint64_t sub_n_avx512(uint64_t* res, uint64_t const* a, uint64_t const* b, size_t n)
+{
+    __m512i const ones = _mm512_set1_epi64(-1);
+    unsigned borrow = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512(a + i), y = _mm512_loadu_si512(b + i);
+        __m512i d = _mm512_sub_epi64(x, y);
+        unsigned g = _mm512_cmplt_epu64_mask(x, y);
+        unsigned p = _mm512_cmpeq_epi64_mask(d, _mm512_setzero_si512());
+        unsigned t = ((g << 1) | borrow) + p;
+        borrow = t >> 8;
+        _mm512_storeu_si512(res + i, _mm512_mask_add_epi64(d, static_cast<__mmask8>(t ^ p), d, ones));
+    }
+    return sub_tail<uint64_t>(res + i, a + i, b + i, n - i, borrow);
+}
+
+SIMD_AVX512 __m512i load_tail(uint32_t const* p, size_t n) // the first n < 16 limbs, zeros above them
+{
+    return _mm512_maskz_loadu_epi32(static_cast<__mmask16>((1u << n) - 1), p);
+}
+
+SIMD_AVX512 __m512i load_tail(uint64_t const* p, size_t n) // n < 8
+{
+    return _mm512_maskz_loadu_epi64(static_cast<__mmask8>((1u << n) - 1), p);
+}
+
+SIMD_AVX512 void store_tail(uint32_t* p, size_t n, __m512i x)
+{
+    _mm512_mask_storeu_epi32(p, static_cast<__mmask16>((1u << n) - 1), x);
+}
+
+SIMD_AVX512 void store_tail(uint64_t* p, size_t n, __m512i x)
+{
+    _mm512_mask_storeu_epi64(p, static_cast<__mmask8>((1u << n) - 1), x);
+}
+
+template<typename Op, typename Limb>
+SIMD_AVX512 void bitwise_avx512(Limb* res, Limb const* a, Limb const* b, size_t n)
+{
+    size_t const step = sizeof(__m512i) / sizeof(Limb);
+    size_t i = 0;
+    for (; i + step <= n; i += step) {
+        _mm512_storeu_si512(res + i, Op()(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)));
+    }
+    if (i < n) {
+        store_tail(res + i, n - i, Op()(load_tail(a + i, n - i), load_tail(b + i, n - i)));
+    }
+}
+
+template<typename Limb>
+SIMD_AVX512 void com_n_avx512(Limb* res, Limb const* a, size_t n)
+{
+    size_t const step = sizeof(__m512i) / sizeof(Limb);
+    __m512i const ones = _mm512_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + step <= n; i += step) {
+        _mm512_storeu_si512(res + i, _mm512_xor_si512(_mm512_loadu_si512(a + i), ones));
+    }
+    if (i < n) {
+        store_tail(res + i, n - i, _mm512_xor_si512(load_tail(a + i, n - i), ones));
+    }
+}
+
+// 8 limbs per step in 64-bit lanes: t = a * val (+ res) < 2^64, the high halves move up one lane
+// and the remaining single-bit carries are resolved on masks; 64-bit limbs only have the IFMA mul_1 below,
+// since built from 32 by 32-bit products like these it loses to the scalar 64 by 64-bit multiplication
+SIMD_AVX512 uint32_t mul_1_avx512(uint32_t* res, uint32_t const* a, size_t n, uint32_t val, bool accumulate)
+{
+    __m512i const factor = _mm512_set1_epi64(val);
+    __m512i const low = _mm512_set1_epi64(0xFFFFFFFF);
+    __m512i const one = _mm512_set1_epi64(1);
+    uint64_t carry = 0; // the exact carry into the next step, below 2^32
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i t = _mm512_mul_epu32(_mm512_cvtepu32_epi64(_mm256_loadu_si256(
+                reinterpret_cast<__m256i const*>(a + i))), factor);
+        if (accumulate) {
+            t = _mm512_add_epi64(t, _mm512_cvtepu32_epi64(_mm256_loadu_si256(
+                    reinterpret_cast<__m256i const*>(res + i))));
+        }
+        __m512i high = _mm512_srli_epi64(t, 32);
+        uint64_t top = static_cast<uint64_t>(_mm256_extract_epi64(_mm512_extracti64x4_epi64(high, 1), 3));
+        __m512i u = _mm512_add_epi64(_mm512_and_si512(t, low),
+                _mm512_alignr_epi64(high, _mm512_set1_epi64(static_cast<long long>(carry)), 7));
+        unsigned g = _mm512_cmpgt_epu64_mask(u, low);
+        unsigned p = _mm512_cmpeq_epu64_mask(u, low);
+        unsigned s = (g << 1) + p;
+        carry = top + (s >> 8);
+        u = _mm512_mask_add_epi64(u, static_cast<__mmask8>(s ^ p), u, one);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(res + i), _mm512_cvtepi64_epi32(u));
+    }
+    return mul_tail(res + i, a + i, n - i, val, static_cast<uint32_t>(carry), accumulate);
+}
+
+SIMD_AVX512 uint32_t mul_1_avx512(uint32_t* res, uint32_t const* a, size_t n, uint32_t val)
+{
+    return mul_1_avx512(res, a, n, val, false);
+}
+
+SIMD_AVX512 uint32_t addmul_1_avx512(uint32_t* res, uint32_t const* a, size_t n, uint32_t val)
+{
+    return mul_1_avx512(res, a, n, val, true);
+}
+
+// 8 limbs per step with the 52-bit multiply-adds of AVX512IFMA: a limb and val are split at bit 52, the partial
+// products are summed in columns of weight 1, 2^52 and 2^104, which normalize to a 128-bit t = a * val per lane,
+// and the high halves move up one lane with the carries resolved on masks as above; there is no addmul_1 from it
+// since a schoolbook row reloads the previous row's vector stores one limb off, which store forwarding cannot serve
+SIMD_AVX512IFMA uint64_t mul_1_ifma(uint64_t* res, uint64_t const* a, size_t n, uint64_t val)
+{
+    __m512i const mask52 = _mm512_set1_epi64((uint64_t(1) << 52) - 1);
+    __m512i const ones = _mm512_set1_epi64(-1);
+    __m512i const one = _mm512_set1_epi64(1);
+    __m512i const zero = _mm512_setzero_si512();
+    __m512i const v0 = _mm512_set1_epi64(static_cast<long long>(val & ((uint64_t(1) << 52) - 1)));
+    __m512i const v1 = _mm512_set1_epi64(static_cast<long long>(val >> 52));
+    uint64_t carry = 0; // the exact carry into the next step
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512(a + i);
+        __m512i x0 = _mm512_and_si512(x, mask52), x1 = _mm512_srli_epi64(x, 52);
+        __m512i c0 = _mm512_madd52lo_epu64(zero, x0, v0);
+        __m512i c1 = _mm512_madd52hi_epu64(zero, x0, v0);
+        c1 = _mm512_madd52lo_epu64(c1, x0, v1);
+        c1 = _mm512_madd52lo_epu64(c1, x1, v0);
+        __m512i c2 = _mm512_madd52hi_epu64(zero, x0, v1);
+        c2 = _mm512_madd52hi_epu64(c2, x1, v0);
+        c2 = _mm512_madd52lo_epu64(c2, x1, v1);
+        c1 = _mm512_add_epi64(c1, _mm512_srli_epi64(c0, 52));
+        __m512i low = _mm512_or_si512(_mm512_and_si512(c0, mask52), _mm512_slli_epi64(c1, 52));
+        __m512i high = _mm512_add_epi64(_mm512_srli_epi64(c1, 12), _mm512_slli_epi64(c2, 40));
+        uint64_t top = static_cast<uint64_t>(_mm256_extract_epi64(_mm512_extracti64x4_epi64(high, 1), 3));
+        __m512i u = _mm512_add_epi64(low,
+                _mm512_alignr_epi64(high, _mm512_set1_epi64(static_cast<long long>(carry)), 7));
+        unsigned g = _mm512_cmplt_epu64_mask(u, low);
+        unsigned p = _mm512_cmpeq_epu64_mask(u, ones);
+        unsigned s = (g << 1) + p;
+        carry = top + (s >> 8);
+        u = _mm512_mask_add_epi64(u, static_cast<__mmask8>(s ^ p), u, one);
+        _mm512_storeu_si512(res + i, u);
+    }
+    return mul_tail(res + i, a + i, n - i, val, carry, false);
+}
+
+// Decimal text: 32 characters are checked by two compares, and digits are combined pairwise by multiply-adds,
+// two digits into 16 bits, four into 32, eight into 32 again after a pack, so a group takes no per-digit steps.
+
+SIMD_AVX2 size_t digit_span_avx2(char const* str, size_t n)
+{
+    __m256i const below = _mm256_set1_epi8('0'), above = _mm256_set1_epi8('9');
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(str + i));
+        __m256i bad = _mm256_or_si256(_mm256_cmpgt_epi8(below, x), _mm256_cmpgt_epi8(x, above)); // bytes >= 0x80 too
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(bad));
+        if (mask) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i < n && '0' <= str[i] && str[i] <= '9'; ++i) { }
+    return i;
+}
+
+SIMD_AVX2 __m128i decimal_octets(__m128i text) // the 32-bit lanes 0 and 1 get the values of bytes 0-7 and 8-15
+{
+    __m128i digits = _mm_sub_epi8(text, _mm_set1_epi8('0'));
+    __m128i pairs = _mm_maddubs_epi16(digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    return _mm_madd_epi16(_mm_packus_epi32(quads, quads), _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+}
+
+SIMD_AVX2 void decimal_chunks_avx2(uint64_t* res, char const* str, size_t n)
+{
+    for (size_t i = 0; i < n; ++i, str += 19) { // 3 digits, then 16 in one register
+        uint64_t head = static_cast<uint64_t>(str[0] - '0') * 100 + (str[1] - '0') * 10 + (str[2] - '0');
+        __m128i octets = decimal_octets(_mm_loadu_si128(reinterpret_cast<__m128i const*>(str + 3)));
+        uint64_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+        uint64_t low = static_cast<uint32_t>(_mm_extract_epi32(octets, 1));
+        res[i] = (head * 100000000 + high) * 100000000 + low;
+    }
+}
+
+SIMD_AVX2 void decimal_chunks_avx2(uint32_t* res, char const* str, size_t n)
+{
+    for (size_t i = 0; i < n; ++i, str += 9) { // 1 digit, then 8 in the low half of a register
+        __m128i octets = decimal_octets(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(str + 1)));
+        res[i] = static_cast<uint32_t>(str[0] - '0') * 100000000 + static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+    }
+}
+#endif
+}
+
+template<>
+simd_kernels<uint32_t> const& simd_kernels<uint32_t>::select(simd_level level)
+{
+    static simd_kernels const portable = {simd_level::none, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                          nullptr, nullptr, nullptr, nullptr};
+#ifdef SIMD_KERNELS_X86
+    static simd_kernels const avx2 = {simd_level::avx2, add_n_avx2, sub_n_avx2, bitwise_avx2<and_op>,
+                                      bitwise_avx2<or_op>, bitwise_avx2<xor_op>, com_n_avx2, nullptr, nullptr,
+                                      digit_span_avx2, decimal_chunks_avx2};
+    static simd_kernels const avx512 = {simd_level::avx512, add_n_avx512, sub_n_avx512, bitwise_avx512<and_op>,
+                                        bitwise_avx512<or_op>, bitwise_avx512<xor_op>, com_n_avx512, mul_1_avx512,
+                                        addmul_1_avx512, digit_span_avx2, decimal_chunks_avx2};
+    switch (level) {
+    case simd_level::avx2:
+        return avx2;
+    case simd_level::avx512:
+        return avx512;
+    case simd_level::none:
+        break;
+    }
+#endif
+    static_cast<void>(level);
+    return portable;
+}
+
+template<>
+simd_kernels<uint64_t> const& simd_kernels<uint64_t>::select(simd_level level)
+{
+    static simd_kernels const portable = {simd_level::none, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                          nullptr, nullptr, nullptr, nullptr};
+#ifdef SIMD_KERNELS_X86
+    static simd_kernels const avx2 = {simd_level::avx2, add_n_avx2, sub_n_avx2, bitwise_avx2<and_op>,
+                                      bitwise_avx2<or_op>, bitwise_avx2<xor_op>, com_n_avx2, nullptr, nullptr,
+                                      digit_span_avx2, decimal_chunks_avx2};
+    static bool const ifma = (__builtin_cpu_init(), __builtin_cpu_supports("avx512ifma")); // not implied by avx512f
+    static simd_kernels const avx512 = {simd_level::avx512, add_n_avx512, sub_n_avx512, bitwise_avx512<and_op>,
+                                        bitwise_avx512<or_op>, bitwise_avx512<xor_op>, com_n_avx512,
+                                        ifma ? mul_1_ifma : nullptr, nullptr,
+                                        digit_span_avx2, decimal_chunks_avx2};
+    switch (level) {
+    case simd_level::avx2:
+        return avx2;
+    case simd_level::avx512:
+        return avx512;
+    case simd_level::none:
+        break;
+    }
+#endif
+    static_cast<void>(level);
+    return portable;
+}
+
+template<typename Limb>
+simd_level simd_kernels<Limb>::detect()
+{
+#ifdef SIMD_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return simd_level::avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return simd_level::avx2;
+    }
+#endif
+    return simd_level::none;
+}
+
+template<typename Limb>
+simd_kernels<Limb> const& simd_kernels<Limb>::best()
+{
+    static simd_kernels const& kernels = select(detect());
+    return kernels;
+}
+
+template struct simd_kernels<uint32_t>;
+template struct simd_kernels<uint64_t>;
@@ -0,0 +1,30 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+enum class simd_level { none, avx2, avx512 };
+
+// vectorized 32- and 64-bit limb kernels with the contracts of their big_integer::helper counterparts;
+// res may coincide with an operand but must not overlap it partially, a null entry means the portable loop is used
+template<typename Limb>
+struct simd_kernels {
+    simd_level level;
+    Limb (* add_n)(Limb* res, Limb const* a, Limb const* b, size_t n); // returns carry
+    Limb (* sub_n)(Limb* res, Limb const* a, Limb const* b, size_t n); // returns borrow
+    void (* and_n)(Limb* res, Limb const* a, Limb const* b, size_t n);
+    void (* or_n)(Limb* res, Limb const* a, Limb const* b, size_t n);
+    void (* xor_n)(Limb* res, Limb const* a, Limb const* b, size_t n);
+    void (* com_n)(Limb* res, Limb const* a, size_t n);
+    Limb (* mul_1)(Limb* res, Limb const* a, size_t n, Limb val); // returns carry
+    Limb (* addmul_1)(Limb* res, Limb const* a, size_t n, Limb val); // res += a * val
+    size_t (* digit_span)(char const* str, size_t n); // the length of the leading run of decimal digits
+    void (* decimal_chunks)(Limb* res, char const* str, size_t n); // n groups of 19 (64-bit) or 9 (32-bit) digits
+
+    static simd_level detect(); // the widest level the running CPU supports
+    static simd_kernels const& select(simd_level level); // levels the CPU lacks must not be called
+    static simd_kernels const& best(); // select(detect()), computed once
+};
+
+#endif //SIMD_KERNELS_H
@@ -0,0 +1,185 @@
+#include "work_stealing_pool.h"
+
+#include <exception>
+
+namespace {
+thread_local work_stealing_pool const* current_pool = nullptr;
+thread_local unsigned current_index = 0;
+
+constexpr unsigned idle_spins = 16; // failed steals before a waiting run() blocks
+}
+
+struct work_stealing_pool::group {
+    std::atomic<size_t> pending;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    void fail(std::exception_ptr e)
+    {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+            error = e;
+        }
+    }
+};
+
+work_stealing_pool::work_stealing_pool(unsigned threads) : queued(0), stop(false)
+{
+    for (unsigned i = 0; i <= 2 * threads; ++i) {
+        queues.emplace_back(new queue());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&work_stealing_pool::work, this, i);
+    }
+}
+
+work_stealing_pool::~work_stealing_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned work_stealing_pool::size() const noexcept
+{
+    return static_cast<unsigned>(workers.size());
+}
+
+void work_stealing_pool::run(std::vector<std::function<void()>>& jobs)
+{
+    if (jobs.empty()) {
+        return;
+    }
+    group g;
+    g.pending = jobs.size() - 1;
+    struct slot { // an outside thread pushes to a queue of its own, also used by the jobs it runs meanwhile
+        work_stealing_pool* pool;
+        work_stealing_pool const* outer_pool;
+        unsigned outer_index;
+
+        explicit slot(work_stealing_pool* pool) : pool(pool), outer_pool(current_pool), outer_index(current_index)
+        {
+            if (outer_pool != pool) {
+                current_pool = pool;
+                current_index = pool->claim();
+            }
+        }
+
+        ~slot()
+        {
+            if (outer_pool != pool) {
+                pool->queues[current_index]->claimed.store(false, std::memory_order_release);
+                current_pool = outer_pool;
+                current_index = outer_index;
+            }
+        }
+    } caller(this);
+    unsigned index = current_index;
+    if (jobs.size() > 1) {
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            for (size_t i = jobs.size(); --i;) { // the owner pops from the back, so the second job comes first
+                queues[index]->tasks.push_back({&jobs[i], &g});
+            }
+            queued += jobs.size() - 1; // still under the lock a thief needs, so the count never trails the queues
+        }
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        wake.notify_all();
+    }
+    try {
+        jobs[0]();
+    }
+    catch (...) {
+        g.fail(std::current_exception());
+    }
+    for (unsigned idle = 0; g.pending.load(std::memory_order_acquire);) {
+        if (try_run(index)) {
+            idle = 0;
+        }
+        else if (++idle < idle_spins) {
+            std::this_thread::yield();
+        }
+        else { // woken by new jobs to steal or by the last job of the group finishing
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            wake.wait(lock, [this, &g] { return !g.pending.load(std::memory_order_acquire) || queued.load() > 0; });
+            idle = 0;
+        }
+    }
+    if (g.error) {
+        std::rethrow_exception(g.error);
+    }
+}
+
+void work_stealing_pool::work(unsigned index)
+{
+    current_pool = this;
+    current_index = index;
+    while (true) {
+        if (try_run(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this] { return stop || queued.load() > 0; });
+        if (stop) {
+            return;
+        }
+    }
+}
+
+unsigned work_stealing_pool::claim()
+{
+    for (size_t i = size(); i + 1 < queues.size(); ++i) {
+        if (!queues[i]->claimed.exchange(true, std::memory_order_acquire)) {
+            return static_cast<unsigned>(i);
+        }
+    }
+    return static_cast<unsigned>(queues.size() - 1);
+}
+
+bool work_stealing_pool::try_run(unsigned index)
+{
+    task t{};
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        if (!queues[index]->tasks.empty()) {
+            t = queues[index]->tasks.back();
+            queues[index]->tasks.pop_back();
+            found = true;
+        }
+    }
+    for (size_t k = 1; !found && k < queues.size(); ++k) {
+        queue& victim = *queues[(index + k) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            t = victim.tasks.front();
+            victim.tasks.pop_front();
+            found = true;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+    --queued;
+    execute(t);
+    return true;
+}
+
+void work_stealing_pool::execute(task const& t)
+{
+    try {
+        (*t.job)();
+    }
+    catch (...) {
+        t.owner->fail(std::current_exception());
+    }
+    if (t.owner->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) { // the owner may be blocked on it
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        wake.notify_all();
+    }
+}
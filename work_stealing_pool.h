@@ -0,0 +1,58 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct work_stealing_pool {
+public:
+    explicit work_stealing_pool(unsigned threads);
+    ~work_stealing_pool();
+
+    work_stealing_pool(work_stealing_pool const& other) = delete;
+    work_stealing_pool& operator=(work_stealing_pool const& other) = delete;
+
+    unsigned size() const noexcept;
+
+    // Runs every job and returns once all of them have finished. The calling thread runs the first job itself and
+    // then executes queued jobs (its own or stolen) while waiting, so jobs may call run() recursively.
+    // The first exception thrown by a job is rethrown here.
+    void run(std::vector<std::function<void()>>& jobs);
+
+private:
+    struct group;
+
+    struct task {
+        std::function<void()>* job;
+        group* owner;
+    };
+
+    struct queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+        std::atomic<bool> claimed{false}; // by the outside thread using it for the duration of its run()
+    };
+
+    // one per worker, then as many for outside threads, each claimed by one of them at a time, and a last one
+    // shared by the outside threads that find all of those claimed
+    std::vector<std::unique_ptr<queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stop;
+
+    void work(unsigned index);
+    unsigned claim();
+    bool try_run(unsigned index);
+    void execute(task const& t);
+};
+
+#endif //WORK_STEALING_POOL_H